@@ -0,0 +1,273 @@
+// Headless scaling benchmark for RSRand and RSSlew
+// Builds the real module sources against the stub engine in stub/ and steps hundreds of
+// RSRand -> target pairs and RSSlew chains on 1..N worker threads the way Rack's engine does:
+// workers pull modules off a shared atomic index each frame, spin barriers separate frames and
+// cables are copied on the main thread between them
+//
+// Usage: rsbench [pairs] [chains] [chain length] [max threads] [blocks]
+
+#include "plugin.hpp"
+#include "RSKernels.hpp"
+
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+void init(Plugin* p);
+
+static const int BLOCK_FRAMES = 256;
+static const int TARGET_PARAMS = 64;
+static const float SAMPLE_RATE = 48000.0f;
+
+typedef std::chrono::steady_clock Clock;
+
+static int64_t nanosSince(Clock::time_point start) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Stands in for whatever module sits to the right of an RSRand
+struct BenchTarget : Module {
+	BenchTarget() {
+		config(TARGET_PARAMS, 0, 0, 0);
+		for(int p = 0; p < TARGET_PARAMS; p++) configParam(p, 0.0f, 10.0f, 5.0f, string::f("Param %d", p));
+	}
+};
+
+struct BenchCable {
+	Module* from;
+	int output;
+	Module* to;
+	int input;
+};
+
+struct SpinBarrier {
+	std::atomic<int> count{0};
+	std::atomic<int> generation{0};
+	int total = 0;
+
+	// Returns ns spent waiting
+	int64_t wait() {
+		Clock::time_point start = Clock::now();
+		int gen = generation.load(std::memory_order_acquire);
+		if(count.fetch_add(1, std::memory_order_acq_rel) == total - 1) {
+			count.store(0, std::memory_order_relaxed);
+			generation.fetch_add(1, std::memory_order_release);
+		}
+		else {
+			// Spin, then yield like Rack's HybridBarrier so oversubscribed runs still finish
+			for(int spins = 0; generation.load(std::memory_order_acquire) == gen; spins++) {
+				if(spins > 4096) std::this_thread::yield();
+#if defined(__x86_64__) || defined(__i386__)
+				else __builtin_ia32_pause();
+#endif
+			}
+		}
+		return nanosSince(start);
+	}
+};
+
+struct Bench {
+	std::vector<Module*> modules;
+	std::vector<BenchCable> cables;
+	std::vector<Module*> randModules;
+	std::vector<Module*> slewHeads;
+	int64_t nextId = 1;
+	int64_t frame = 0;
+
+	Module* add(Model* model) {
+		Module* m = model->createModule();
+		m->id = nextId++;
+		ModuleWidget* mw = model->createModuleWidget(m);
+		APP->engine->modules[m->id] = m;
+		APP->scene->rack->modules[m->id] = mw;
+		modules.push_back(m);
+		return m;
+	}
+
+	template <class TModule>
+	Module* addPlain() {
+		struct PlainWidget : ModuleWidget {
+			PlainWidget(TModule* module) {
+				setModule(module);
+				for(int p = 0; p < (int)module->params.size(); p++) addParam(createParamCentered<SvgKnob>(Vec(), module, p));
+			}
+		};
+		static Model* model = createModel<TModule, PlainWidget>("BenchTarget");
+		return add(model);
+	}
+
+	void build(int pairs, int chains, int chainLength) {
+		for(int p = 0; p < pairs; p++) {
+			Module* rand = add(modelRSRand);
+			Module* target = addPlain<BenchTarget>();
+			rand->rightExpander.moduleId = target->id;
+			rand->params[2].setValue(0.25f);	// SLEW_KNOB, keep slews in flight
+			randModules.push_back(rand);
+		}
+
+		for(int c = 0; c < chains; c++) {
+			Module* prev = NULL;
+			for(int l = 0; l < chainLength; l++) {
+				Module* slew = add(modelRSSlew);
+				slew->params[0].setValue(0.01f);
+				if(prev) cables.push_back({prev, 0, slew, 0});
+				else slewHeads.push_back(slew);
+				prev = slew;
+			}
+		}
+	}
+
+	// Main thread, between frames
+	void stepCables() {
+		int64_t f = frame;
+		for(Module* rand : randModules) {
+			// Trigger every 4800 frames, staggered so they don't all land together
+			bool high = ((f + rand->id * 37) % 4800) < 64;
+			rand->inputs[0].setChannels(1);
+			rand->inputs[0].setVoltage(high ? 10.0f : 0.0f);
+		}
+		for(Module* head : slewHeads) {
+			head->inputs[0].setChannels(16);
+			for(int c = 0; c < 16; c++) head->inputs[0].setVoltage(((f / 480 + c) % 10) * 0.5f, c);
+		}
+		for(const BenchCable& cable : cables) {
+			engine::Output& out = cable.from->outputs[cable.output];
+			engine::Input& in = cable.to->inputs[cable.input];
+			in.setChannels(out.getChannels());
+			std::memcpy(in.voltages, out.voltages, sizeof(in.voltages));
+		}
+	}
+};
+
+struct Result {
+	int threads;
+	double framesPerSecond;
+	double p50, p99, p999, maxNs;
+	double waitFraction;
+};
+
+static Result run(Bench& bench, int threads, int blocks) {
+	SpinBarrier barrier;
+	barrier.total = threads;
+	std::atomic<int> moduleIndex{0};
+	std::atomic<bool> running{true};
+	std::vector<int64_t> waitNs(threads, 0);
+	std::vector<int64_t> blockNs;
+	blockNs.reserve(blocks);
+
+	Module::ProcessArgs args;
+	args.sampleRate = SAMPLE_RATE;
+	args.sampleTime = 1.0f / SAMPLE_RATE;
+
+	int numModules = (int)bench.modules.size();
+
+	// One frame of module processing, shared by every thread
+	auto stepModules = [&](int thread) {
+		while(true) {
+			int i = moduleIndex.fetch_add(1, std::memory_order_relaxed);
+			if(i >= numModules) break;
+			Module::ProcessArgs a = args;
+			a.frame = bench.frame;
+			bench.modules[i]->process(a);
+		}
+	};
+
+	auto worker = [&](int thread) {
+		while(true) {
+			waitNs[thread] += barrier.wait();	// Frame start
+			if(!running.load(std::memory_order_relaxed)) break;
+			stepModules(thread);
+			waitNs[thread] += barrier.wait();	// Frame end
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(int t = 1; t < threads; t++) workers.push_back(std::thread(worker, t));
+
+	Clock::time_point runStart = Clock::now();
+	for(int b = 0; b < blocks; b++) {
+		Clock::time_point blockStart = Clock::now();
+		for(int f = 0; f < BLOCK_FRAMES; f++) {
+			bench.stepCables();
+			moduleIndex.store(0, std::memory_order_relaxed);
+			waitNs[0] += barrier.wait();
+			stepModules(0);
+			waitNs[0] += barrier.wait();
+			bench.frame++;
+		}
+		blockNs.push_back(nanosSince(blockStart));
+	}
+	int64_t runNs = nanosSince(runStart);
+
+	running = false;
+	barrier.wait();
+	for(std::thread& t : workers) t.join();
+
+	std::sort(blockNs.begin(), blockNs.end());
+	auto percentile = [&](double p) { return (double)blockNs[std::min((size_t)(p * blockNs.size()), blockNs.size() - 1)]; };
+
+	int64_t totalWait = 0;
+	for(int64_t w : waitNs) totalWait += w;
+
+	Result r;
+	r.threads = threads;
+	r.framesPerSecond = (double)blocks * BLOCK_FRAMES / (runNs * 1e-9);
+	r.p50 = percentile(0.5);
+	r.p99 = percentile(0.99);
+	r.p999 = percentile(0.999);
+	r.maxNs = (double)blockNs.back();
+	r.waitFraction = (double)totalWait / ((double)runNs * threads);
+	return r;
+}
+
+int main(int argc, char** argv) {
+	int pairs = argc > 1 ? atoi(argv[1]) : 200;
+	int chains = argc > 2 ? atoi(argv[2]) : 50;
+	int chainLength = argc > 3 ? atoi(argv[3]) : 8;
+	int maxThreads = argc > 4 ? atoi(argv[4]) : (int)std::max(1u, std::thread::hardware_concurrency());
+	int blocks = argc > 5 ? atoi(argv[5]) : 200;
+
+	if(pairs < 0 || chains < 0 || chainLength < 1 || maxThreads < 1 || blocks < 1) {
+		fprintf(stderr, "Usage: rsbench [pairs >= 0] [chains >= 0] [chain length >= 1] [max threads >= 1] [blocks >= 1]\n");
+		return 1;
+	}
+
+	Plugin plugin;
+	init(&plugin);
+
+	Bench bench;
+	bench.build(pairs, chains, chainLength);
+
+	// Warm up, first ticks scan the right modules and the modules chat on stdout while doing it
+	fflush(stdout);
+	int savedStdout = dup(1);
+	int devNull = open("/dev/null", O_WRONLY);
+	dup2(devNull, 1);
+	run(bench, 1, 8);
+	fflush(stdout);
+	dup2(savedStdout, 1);
+	close(devNull);
+	close(savedStdout);
+
+	printf("%d RSRand/target pairs (%d params), %d RSSlew chains x %d (16 ch), %d modules, %s kernels\n",
+		pairs, TARGET_PARAMS, chains, chainLength, (int)bench.modules.size(), rsKernels->name);
+	printf("%d blocks of %d frames, realtime block is %.0f us\n\n", blocks, BLOCK_FRAMES, BLOCK_FRAMES / SAMPLE_RATE * 1e6);
+	printf("threads  frames/s    x realtime  scaling  block p50 us  p99 us  p99.9 us  max us  barrier wait\n");
+
+	double baseline = 0.0;
+	for(int threads = 1; threads <= maxThreads;) {
+		Result r = run(bench, threads, blocks);
+		if(threads == 1) baseline = r.framesPerSecond;
+		printf("%7d  %10.0f  %10.2f  %7.2f  %12.1f  %6.1f  %8.1f  %6.1f  %11.1f%%\n",
+			r.threads, r.framesPerSecond, r.framesPerSecond / SAMPLE_RATE, r.framesPerSecond / baseline,
+			r.p50 * 1e-3, r.p99 * 1e-3, r.p999 * 1e-3, r.maxNs * 1e-3, r.waitFraction * 100.0);
+
+		// Powers of 2, finishing on maxThreads itself
+		int next = threads * 2;
+		if(threads < maxThreads && next > maxThreads) next = maxThreads;
+		threads = next;
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include <rack.hpp>
+
+#include <cstdarg>
+#include <chrono>
+#include <sys/stat.h>
+
+// JSON is never exercised by rsbench, these only satisfy the linker
+json_t* json_object() { return NULL; }
+json_t* json_object_get(const json_t*, const char*) { return NULL; }
+int json_object_set_new(json_t*, const char*, json_t*) { return -1; }
+json_t* json_integer(long long) { return NULL; }
+json_t* json_real(double) { return NULL; }
+json_t* json_boolean(bool) { return NULL; }
+json_t* json_string(const char*) { return NULL; }
+json_t* json_array() { return NULL; }
+int json_array_append_new(json_t*, json_t*) { return -1; }
+long long json_integer_value(const json_t*) { return 0; }
+double json_real_value(const json_t*) { return 0.0; }
+double json_number_value(const json_t*) { return 0.0; }
+const char* json_string_value(const json_t*) { return NULL; }
+bool json_is_true(const json_t*) { return false; }
+void json_decref(json_t*) {}
+
+namespace rack {
+
+namespace string {
+std::string f(const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	char buf[1024];
+	vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+	return buf;
+}
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string toBase64(const uint8_t* data, size_t dataLen) {
+	std::string str;
+	for(size_t i = 0; i < dataLen; i += 3) {
+		uint32_t n = data[i] << 16;
+		if(i + 1 < dataLen) n |= data[i + 1] << 8;
+		if(i + 2 < dataLen) n |= data[i + 2];
+		str += base64Chars[(n >> 18) & 63];
+		str += base64Chars[(n >> 12) & 63];
+		str += i + 1 < dataLen ? base64Chars[(n >> 6) & 63] : '=';
+		str += i + 2 < dataLen ? base64Chars[n & 63] : '=';
+	}
+	return str;
+}
+
+std::vector<uint8_t> fromBase64(const std::string& str) {
+	std::vector<uint8_t> data;
+	uint32_t n = 0;
+	int bits = 0;
+	for(char c : str) {
+		const char* p = std::strchr(base64Chars, c);
+		if(c == '=' || !c || !p) continue;
+		n = (n << 6) | (uint32_t)(p - base64Chars);
+		bits += 6;
+		if(bits >= 8) {
+			bits -= 8;
+			data.push_back((n >> bits) & 0xff);
+		}
+	}
+	return data;
+}
+}
+
+namespace asset {
+std::string plugin(Plugin* plugin, const std::string& filename) { return filename; }
+std::string user(const std::string& filename) { return filename; }
+}
+
+namespace random {
+uint32_t u32() {
+	static std::atomic<uint32_t> next{0x12345678};
+	return next.fetch_add(0x9e3779b9u);
+}
+}
+
+namespace system {
+bool createDirectories(const std::string& path) { return mkdir(path.c_str(), 0755) == 0; }
+int64_t getNanoseconds() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+static engine::Engine stubEngine;
+static app::RackWidget stubRack;
+static app::Scene stubScene;
+static window::Window stubWindow;
+static history::State stubHistory;
+
+static Context stubContext = [] {
+	Context c;
+	stubScene.rack = &stubRack;
+	c.engine = &stubEngine;
+	c.scene = &stubScene;
+	c.window = &stubWindow;
+	c.history = &stubHistory;
+	return c;
+}();
+
+Context* contextGet() { return &stubContext; }
+
+}
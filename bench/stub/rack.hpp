@@ -0,0 +1,569 @@
+// Minimal stand-in for the parts of the Rack SDK the RS modules use, enough to build and step them
+// headless for rsbench. Widgets and drawing are no-ops and JSON is declared but not implemented,
+// the benchmark never serialises.
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+
+typedef struct { float r, g, b, a; } NVGcolor;
+struct NVGcontext {};
+inline NVGcolor nvgRGB(int r, int g, int b) { return NVGcolor{r / 255.f, g / 255.f, b / 255.f, 1.f}; }
+inline void nvgStrokeColor(NVGcontext*, NVGcolor) {}
+inline void nvgFillColor(NVGcontext*, NVGcolor) {}
+inline void nvgStrokeWidth(NVGcontext*, float) {}
+inline void nvgBeginPath(NVGcontext*) {}
+inline void nvgRoundedRect(NVGcontext*, float, float, float, float, float) {}
+inline void nvgStroke(NVGcontext*) {}
+inline void nvgFill(NVGcontext*) {}
+inline void nvgFontSize(NVGcontext*, float) {}
+inline void nvgFontFaceId(NVGcontext*, int) {}
+inline void nvgTextLetterSpacing(NVGcontext*, float) {}
+inline void nvgTextAlign(NVGcontext*, int) {}
+inline float nvgText(NVGcontext*, float, float, const char*, const char*) { return 0.f; }
+enum { NVG_ALIGN_CENTER = 2 };
+inline void bndSetFont(int) {}
+
+typedef struct json_t json_t;
+json_t* json_object();
+json_t* json_object_get(const json_t*, const char*);
+int json_object_set_new(json_t*, const char*, json_t*);
+json_t* json_integer(long long);
+json_t* json_real(double);
+json_t* json_boolean(bool);
+json_t* json_string(const char*);
+json_t* json_array();
+int json_array_append_new(json_t*, json_t*);
+long long json_integer_value(const json_t*);
+double json_real_value(const json_t*);
+double json_number_value(const json_t*);
+const char* json_string_value(const json_t*);
+bool json_is_true(const json_t*);
+void json_decref(json_t*);
+#define json_boolean_value json_is_true
+
+namespace rack {
+
+namespace plugin {
+struct Plugin;
+struct Model;
+}
+using plugin::Plugin;
+using plugin::Model;
+namespace engine {
+struct Module;
+}
+
+namespace math {
+struct Vec {
+	float x = 0.f, y = 0.f;
+	Vec() {}
+	Vec(float x, float y) : x(x), y(y) {}
+};
+struct Rect {
+	Vec pos, size;
+};
+}
+using math::Vec;
+using math::Rect;
+
+inline float mm2px(float mm) { return mm * 75.f / 25.4f; }
+
+namespace string {
+std::string f(const char* format, ...);
+std::string toBase64(const uint8_t* data, size_t dataLen);
+std::vector<uint8_t> fromBase64(const std::string& str);
+}
+
+namespace asset {
+std::string plugin(Plugin* plugin, const std::string& filename);
+std::string user(const std::string& filename);
+}
+
+namespace random {
+uint32_t u32();
+}
+
+namespace system {
+bool createDirectories(const std::string& path);
+int64_t getNanoseconds();
+}
+
+namespace dsp {
+struct ClockDivider {
+	uint32_t clock = 0, division = 1;
+	void reset() { clock = 0; }
+	void setDivision(uint32_t d) { division = d; }
+	uint32_t getDivision() { return division; }
+	bool process() {
+		if(++clock >= division) { clock = 0; return true; }
+		return false;
+	}
+};
+struct SchmittTrigger {
+	bool state = true;
+	bool process(float in) {
+		if(state) { if(in <= 0.f) state = false; }
+		else if(in >= 1.f) { state = true; return true; }
+		return false;
+	}
+};
+}
+
+namespace engine {
+struct Param {
+	float value = 0.f;
+	float getValue() { return value; }
+	void setValue(float v) { value = v; }
+};
+
+struct Port {
+	float voltages[16] = {};
+	uint8_t channels = 0;
+	float getVoltage(int c = 0) { return voltages[c]; }
+	void setVoltage(float v, int c = 0) { voltages[c] = v; }
+	float* getVoltages(int firstChannel = 0) { return &voltages[firstChannel]; }
+	int getChannels() { return channels; }
+	void setChannels(int c) { channels = c; }
+	bool isConnected() { return channels > 0; }
+};
+struct Input : Port {};
+struct Output : Port {};
+
+struct Light {
+	float value = 0.f;
+	void setBrightness(float b) { value = b; }
+	void setBrightnessSmooth(float b, float) { value = b; }
+	float getBrightness() { return value; }
+};
+
+struct PortInfo {
+	std::string name;
+};
+
+struct ParamQuantity {
+	Module* module = NULL;
+	int paramId = 0;
+	float minValue = 0.f, maxValue = 1.f, defaultValue = 0.f;
+	std::string name, unit;
+	bool randomizeEnabled = true;
+	float displayBase = 0.f, displayMultiplier = 1.f;
+	float getValue();
+	void setValue(float v);
+	float getScaledValue() { return (getValue() - minValue) / (maxValue - minValue); }
+	void setScaledValue(float v) { setValue(minValue + v * (maxValue - minValue)); }
+	float getMinValue() { return minValue; }
+	float getMaxValue() { return maxValue; }
+	virtual ~ParamQuantity() {}
+};
+
+struct SwitchQuantity : ParamQuantity {
+	std::vector<std::string> labels;
+};
+
+struct Module {
+	int64_t id = -1;
+	Model* model = NULL;
+	std::vector<Param> params;
+	std::vector<Input> inputs;
+	std::vector<Output> outputs;
+	std::vector<Light> lights;
+	std::vector<ParamQuantity*> paramQuantities;
+
+	struct Expander {
+		int64_t moduleId = -1;
+		Module* module = NULL;
+	};
+	Expander leftExpander, rightExpander;
+
+	struct ProcessArgs {
+		float sampleRate = 48000.f;
+		float sampleTime = 1.f / 48000.f;
+		int64_t frame = 0;
+	};
+
+	virtual ~Module() {
+		for(ParamQuantity* pq : paramQuantities) delete pq;
+	}
+
+	void config(int numParams, int numInputs, int numOutputs, int numLights = 0) {
+		params.resize(numParams);
+		inputs.resize(numInputs);
+		outputs.resize(numOutputs);
+		lights.resize(numLights);
+		paramQuantities.resize(numParams, NULL);
+	}
+
+	template <class TParamQuantity = ParamQuantity>
+	TParamQuantity* configParam(int paramId, float minValue, float maxValue, float defaultValue, std::string name = "", std::string unit = "", float displayBase = 0.f, float displayMultiplier = 1.f, float displayOffset = 0.f) {
+		delete paramQuantities[paramId];
+		TParamQuantity* q = new TParamQuantity;
+		q->module = this;
+		q->paramId = paramId;
+		q->minValue = minValue;
+		q->maxValue = maxValue;
+		q->defaultValue = defaultValue;
+		q->name = name;
+		q->unit = unit;
+		q->displayBase = displayBase;
+		q->displayMultiplier = displayMultiplier;
+		paramQuantities[paramId] = q;
+		params[paramId].value = defaultValue;
+		return q;
+	}
+	template <class TSwitchQuantity = SwitchQuantity>
+	TSwitchQuantity* configSwitch(int paramId, float minValue, float maxValue, float defaultValue, std::string name = "", std::vector<std::string> labels = {}) {
+		TSwitchQuantity* q = configParam<TSwitchQuantity>(paramId, minValue, maxValue, defaultValue, name);
+		q->labels = labels;
+		return q;
+	}
+	template <class TSwitchQuantity = SwitchQuantity>
+	TSwitchQuantity* configButton(int paramId, std::string name = "") {
+		TSwitchQuantity* q = configParam<TSwitchQuantity>(paramId, 0.f, 1.f, 0.f, name);
+		q->randomizeEnabled = false;
+		return q;
+	}
+	PortInfo* configInput(int, std::string = "") { return NULL; }
+	PortInfo* configOutput(int, std::string = "") { return NULL; }
+	void configBypass(int, int) {}
+	void configLight(int, std::string = "") {}
+
+	ParamQuantity* getParamQuantity(int id) { return paramQuantities[id]; }
+	int64_t getId() { return id; }
+
+	virtual void process(const ProcessArgs& args) {}
+	virtual void onReset() {}
+	virtual json_t* dataToJson() { return NULL; }
+	virtual void dataFromJson(json_t* rootJ) {}
+};
+
+inline float ParamQuantity::getValue() { return module->params[paramId].getValue(); }
+inline void ParamQuantity::setValue(float v) { module->params[paramId].setValue(std::max(minValue, std::min(v, maxValue))); }
+
+struct Engine {
+	std::map<int64_t, Module*> modules;
+	Module* getModule(int64_t moduleId) {
+		auto it = modules.find(moduleId);
+		return it == modules.end() ? NULL : it->second;
+	}
+	void setParamValue(Module* module, int paramId, float value) { module->params[paramId].setValue(value); }
+	float getParamValue(Module* module, int paramId) { return module->params[paramId].getValue(); }
+	float getSampleRate() { return 48000.f; }
+};
+}
+using engine::Module;
+using engine::ParamQuantity;
+
+namespace window {
+struct Font {
+	int handle = -1;
+};
+struct Svg {};
+struct Window {
+	std::shared_ptr<Font> uiFont = std::make_shared<Font>();
+	std::shared_ptr<Font> loadFont(const std::string&) { return uiFont; }
+	std::shared_ptr<Svg> loadSvg(const std::string&) { return std::make_shared<Svg>(); }
+};
+}
+using window::Font;
+
+namespace event {
+struct Change {};
+struct Action {};
+}
+
+namespace widget {
+struct Widget {
+	Rect box;
+	Widget* parent = NULL;
+	std::vector<Widget*> children;
+	bool visible = true;
+	struct DrawArgs {
+		NVGcontext* vg = NULL;
+	};
+	virtual ~Widget() {
+		for(Widget* child : children) delete child;
+	}
+	void addChild(Widget* child) { child->parent = this; children.push_back(child); }
+	void show() { visible = true; }
+	void hide() { visible = false; }
+	virtual void step() {}
+	virtual void draw(const DrawArgs& args) {}
+	virtual void onChange(const event::Change& e) {}
+	virtual void onAction(const event::Action& e) {}
+};
+struct OpaqueWidget : Widget {};
+struct TransparentWidget : Widget {};
+struct FramebufferWidget : Widget {};
+}
+using widget::Widget;
+using widget::OpaqueWidget;
+using widget::TransparentWidget;
+
+namespace ui {
+struct MenuEntry : OpaqueWidget {
+	std::string text, rightText;
+};
+struct Menu : OpaqueWidget {};
+struct MenuSeparator : MenuEntry {};
+struct MenuLabel : MenuEntry {};
+struct MenuItem : MenuEntry {
+	std::function<void()> action;
+	void onAction(const event::Action& e) override { if(action) action(); }
+};
+}
+using ui::Menu;
+using ui::MenuItem;
+using ui::MenuLabel;
+using ui::MenuSeparator;
+
+namespace app {
+struct ShadowWidget {
+	float opacity = 1.f;
+};
+
+struct ParamWidget : OpaqueWidget {
+	Module* module = NULL;
+	int paramId = -1;
+	ParamQuantity* getParamQuantity() { return module ? module->paramQuantities[paramId] : NULL; }
+};
+struct PortWidget : OpaqueWidget {
+	Module* module = NULL;
+	int portId = -1;
+	bool input = true;
+};
+struct LightWidget : TransparentWidget {};
+struct ModuleLightWidget : LightWidget {
+	Module* module = NULL;
+	int firstLightId = -1;
+};
+struct LedDisplay : Widget {};
+
+struct SvgKnob : ParamWidget {
+	float minAngle = -M_PI, maxAngle = M_PI;
+	bool snap = false;
+	ShadowWidget _shadow;
+	ShadowWidget* shadow = &_shadow;
+	void setSvg(std::shared_ptr<window::Svg>) {}
+};
+struct SvgSwitch : ParamWidget {
+	bool momentary = false;
+	ShadowWidget _shadow;
+	ShadowWidget* shadow = &_shadow;
+	void addFrame(std::shared_ptr<window::Svg>) {}
+	void onChange(const event::Change& e) override {}
+};
+struct SvgPort : PortWidget {
+	void setSvg(std::shared_ptr<window::Svg>) {}
+};
+typedef SvgKnob SVGKnob;
+typedef SvgSwitch SVGSwitch;
+typedef SvgPort SVGPort;
+
+struct CableWidget : Widget {
+	PortWidget* inputPort = NULL;
+	PortWidget* outputPort = NULL;
+};
+
+struct ModuleWidget : OpaqueWidget {
+	Model* model = NULL;
+	Module* module = NULL;
+	std::vector<ParamWidget*> params;
+	~ModuleWidget() { delete module; }
+	void setModule(Module* m) { module = m; }
+	Module* getModule() { return module; }
+	void addParam(ParamWidget* pw) { params.push_back(pw); addChild(pw); }
+	void addInput(PortWidget* pw) { addChild(pw); }
+	void addOutput(PortWidget* pw) { addChild(pw); }
+	std::vector<ParamWidget*> getParams() { return params; }
+	void draw(const DrawArgs& args) override {}
+	virtual void appendContextMenu(Menu* menu) {}
+};
+
+struct RackWidget : Widget {
+	std::map<int64_t, ModuleWidget*> modules;
+	ModuleWidget* getModule(int64_t moduleId) {
+		auto it = modules.find(moduleId);
+		return it == modules.end() ? NULL : it->second;
+	}
+	CableWidget* getIncompleteCable() { return NULL; }
+};
+
+struct Scene : Widget {
+	RackWidget* rack = NULL;
+};
+}
+using app::ModuleWidget;
+using app::ParamWidget;
+using app::PortWidget;
+using app::SvgKnob;
+using app::SvgSwitch;
+using app::SvgPort;
+using app::SVGKnob;
+using app::SVGSwitch;
+using app::SVGPort;
+using app::LedDisplay;
+using app::CableWidget;
+using app::ModuleLightWidget;
+
+namespace history {
+struct Action {
+	std::string name;
+	virtual ~Action() {}
+	virtual void undo() {}
+	virtual void redo() {}
+};
+struct ModuleAction : Action {
+	int64_t moduleId = -1;
+};
+struct State {
+	std::vector<Action*> actions;
+	~State() { for(Action* a : actions) delete a; }
+	void push(Action* action) { actions.push_back(action); }
+};
+}
+
+namespace plugin {
+struct Model {
+	std::string slug;
+	virtual ~Model() {}
+	virtual Module* createModule() = 0;
+	virtual ModuleWidget* createModuleWidget(Module* m) = 0;
+};
+struct Plugin {
+	std::vector<Model*> models;
+	void addModel(Model* model) { models.push_back(model); }
+};
+}
+using plugin::Plugin;
+using plugin::Model;
+
+struct Context {
+	engine::Engine* engine = NULL;
+	app::Scene* scene = NULL;
+	window::Window* window = NULL;
+	history::State* history = NULL;
+};
+Context* contextGet();
+#define APP rack::contextGet()
+
+template <class TModule, class TModuleWidget>
+Model* createModel(std::string slug) {
+	struct TModel : Model {
+		Module* createModule() override {
+			Module* m = new TModule;
+			m->model = this;
+			return m;
+		}
+		ModuleWidget* createModuleWidget(Module* m) override {
+			TModule* tm = NULL;
+			if(m) tm = dynamic_cast<TModule*>(m);
+			ModuleWidget* mw = new TModuleWidget(tm);
+			mw->model = this;
+			return mw;
+		}
+	};
+	Model* o = new TModel;
+	o->slug = slug;
+	return o;
+}
+
+template <class TParamWidget>
+TParamWidget* createParamCentered(math::Vec pos, engine::Module* module, int paramId) {
+	TParamWidget* o = new TParamWidget;
+	o->box.pos = pos;
+	o->module = module;
+	o->paramId = paramId;
+	return o;
+}
+template <class TPortWidget>
+TPortWidget* createInputCentered(math::Vec pos, engine::Module* module, int inputId) {
+	TPortWidget* o = new TPortWidget;
+	o->box.pos = pos;
+	o->module = module;
+	o->portId = inputId;
+	o->input = true;
+	return o;
+}
+template <class TPortWidget>
+TPortWidget* createOutputCentered(math::Vec pos, engine::Module* module, int outputId) {
+	TPortWidget* o = new TPortWidget;
+	o->box.pos = pos;
+	o->module = module;
+	o->portId = outputId;
+	o->input = false;
+	return o;
+}
+template <class TModuleLightWidget>
+TModuleLightWidget* createLightCentered(math::Vec pos, engine::Module* module, int firstLightId) {
+	TModuleLightWidget* o = new TModuleLightWidget;
+	o->box.pos = pos;
+	o->module = module;
+	o->firstLightId = firstLightId;
+	return o;
+}
+
+template <class TMenuItem = ui::MenuItem>
+TMenuItem* createMenuItem(std::string text, std::string rightText = "", std::function<void()> action = NULL, bool disabled = false) {
+	TMenuItem* item = new TMenuItem;
+	item->text = text;
+	item->rightText = rightText;
+	item->action = action;
+	return item;
+}
+template <class TMenuLabel = ui::MenuLabel>
+TMenuLabel* createMenuLabel(std::string text) {
+	TMenuLabel* label = new TMenuLabel;
+	label->text = text;
+	return label;
+}
+template <class TMenuItem = ui::MenuItem>
+TMenuItem* createBoolMenuItem(std::string text, std::string rightText, std::function<bool()> getter, std::function<void(bool)> setter, bool disabled = false) {
+	TMenuItem* item = createMenuItem<TMenuItem>(text, rightText);
+	item->action = [=]() { setter(!getter()); };
+	return item;
+}
+template <typename T>
+ui::MenuItem* createBoolPtrMenuItem(std::string text, std::string rightText, T* ptr) {
+	return createBoolMenuItem(text, rightText, [=]() { return ptr ? *ptr : false; }, [=](T val) { if(ptr) *ptr = val; });
+}
+inline ui::MenuItem* createIndexPtrSubmenuItem(std::string text, std::vector<std::string> labels, int* ptr) {
+	return createMenuItem(text, labels[*ptr]);
+}
+
+template <class TWidget>
+TWidget* createWidget(math::Vec pos) {
+	TWidget* o = new TWidget;
+	o->box.pos = pos;
+	return o;
+}
+
+namespace componentlibrary {
+template <typename TBase = ModuleLightWidget>
+struct TGrayModuleLightWidget : TBase {};
+template <typename TBase = ModuleLightWidget>
+struct TWhiteLight : TBase {};
+template <typename TBase>
+struct SmallLight : TBase {};
+template <typename TBase>
+struct TinyLight : TBase {};
+template <typename TBase>
+struct MediumLight : TBase {};
+typedef TWhiteLight<> WhiteLight;
+}
+using namespace componentlibrary;
+
+}
+
+#define INFO(format, ...) std::fprintf(stderr, "[info] " format "\n", ##__VA_ARGS__)
+#define WARN(format, ...) std::fprintf(stderr, "[warn] " format "\n", ##__VA_ARGS__)
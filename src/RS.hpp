@@ -1,3 +1,5 @@
+#pragma once
+
 #define COLOR_RS_GREY   nvgRGB(0x19, 0x19, 0x19)
 #define COLOR_RS_BRONZE nvgRGB(0x85, 0x87, 0x39)
 #define COLOR_RS_LABEL  nvgRGB(0xf0, 0xf0, 0xf0)
@@ -11,6 +13,23 @@
 #define RS_TITLE_FONT_SIZE 14
 #define RS_LABEL_FONT_SIZE 11
 
+// Packed JSON, large arrays go in as one base64 block of raw values rather than a node per value
+template <typename T>
+json_t* rsPackedToJson(const std::vector<T>& values) {
+	return json_string(string::toBase64((const uint8_t*)values.data(), values.size() * sizeof(T)).c_str());
+}
+
+template <typename T>
+bool rsPackedFromJson(json_t* valueJ, std::vector<T>& values) {
+	const char* packed = json_string_value(valueJ);
+	if(!packed) return false;
+
+	std::vector<uint8_t> bytes = string::fromBase64(packed);
+	values.resize(bytes.size() / sizeof(T));
+	if(!values.empty()) std::memcpy(values.data(), bytes.data(), values.size() * sizeof(T));
+	return true;
+}
+
 // Labels
 struct RSLabel : LedDisplay {
 	int fontSize;
@@ -0,0 +1,23 @@
+// Baseline build of the DSP kernels, whatever plugin.mk targets (nehalem / SSE4.2 on x64)
+
+#define RS_KERNELS_ISA rsKernelsBaselineImpl
+#include "RSKernelsImpl.hpp"
+
+static const RSKernels rsKernelsBaseline = RS_KERNELS_TABLE("baseline");
+
+#ifdef RS_KERNELS_X86
+extern const RSKernels rsKernelsAVX2;
+extern const RSKernels rsKernelsAVX512;
+#endif
+
+const RSKernels* rsKernels = &rsKernelsBaseline;
+
+void rsKernelsInit() {
+	rsKernels = &rsKernelsBaseline;
+
+#ifdef RS_KERNELS_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) rsKernels = &rsKernelsAVX512;
+	else if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) rsKernels = &rsKernelsAVX2;
+#endif
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+// Hot DSP loops built once per instruction set, the best table for the host CPU is picked by
+// rsKernelsInit() from the plugin init()
+// Kept free of Rack and std headers so no inline code gets compiled with wider ISA flags
+
+// Index into RSKernels::slew for a compile time channel count, 0 for any other count
+constexpr int rsKernelWidth(int channels) {
+	return channels == 1 ? 1 : channels == 4 ? 2 : channels == 8 ? 3 : channels == 16 ? 4 : 0;
+}
+
+#define RS_NOISE_LANES 16
+
+// Batched noise, one xorshift32 generator per lane so a block of lanes steps as a vector
+struct RSNoise {
+	uint32_t state[RS_NOISE_LANES];
+
+	void seed(uint32_t seed) {
+		for(int lane = 0; lane < RS_NOISE_LANES; lane++) {
+			uint32_t z = (seed += 0x9e3779b9u);
+			z = (z ^ (z >> 16)) * 0x85ebca6bu;
+			z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+			z ^= z >> 16;
+			state[lane] = z ? z : 1;	// xorshift sticks at 0
+		}
+	}
+};
+
+// Words needed for a packed mask of count bits, bit i of word i / 64 for param i
+constexpr int rsMaskWords(int count) {
+	return (count + 63) / 64;
+}
+
+// Room needed for count noise values, the noise kernel fills whole blocks of lanes
+constexpr int rsNoiseSize(int count) {
+	return (count + RS_NOISE_LANES - 1) / RS_NOISE_LANES * RS_NOISE_LANES;
+}
+
+struct RSKernels {
+	const char* name;
+
+	// RSSlew, one linear glide per channel, returns the number of channels slewing
+	int (*slew[5])(float* prior, float* target, int32_t* offset, const float* in, float* out, float* gate, int channels, int shiftTime);
+
+	// RSRand trigger, out = clamp(base + noise * amount, 0, 1)
+	void (*randBlend)(const float* base, const float* noise, float amount, float* out, int count);
+
+	// RSRand param slew, sets the bits of the params to write in mask (rsMaskWords(count) words), returns how many are slewing
+	int (*randSlew)(const float* current, float* prior, float* target, int32_t* offset, float* out, uint64_t* mask, int count, int shiftTime);
+
+	// Uniform noise in [-0.5, 0.5), out needs rsNoiseSize(count) floats
+	void (*noise)(RSNoise& noise, float* out, int count);
+
+	// RSRand random walk, current += noise * step, reflected to within base +/- range / 2 and 0..1
+	void (*walk)(float* current, const float* base, const float* noise, float step, float range, int count);
+};
+
+extern const RSKernels* rsKernels;
+
+void rsKernelsInit();
@@ -0,0 +1,10 @@
+// AVX2 build of the DSP kernels, compiled with -mavx2 -mfma on x64 (see Makefile)
+
+#ifdef RS_KERNELS_X86
+
+#define RS_KERNELS_ISA rsKernelsAVX2Impl
+#include "RSKernelsImpl.hpp"
+
+extern const RSKernels rsKernelsAVX2 = RS_KERNELS_TABLE("AVX2");
+
+#endif
@@ -0,0 +1,10 @@
+// AVX-512 build of the DSP kernels, compiled with -mavx512f -mavx512vl on x64 (see Makefile)
+
+#ifdef RS_KERNELS_X86
+
+#define RS_KERNELS_ISA rsKernelsAVX512Impl
+#include "RSKernelsImpl.hpp"
+
+extern const RSKernels rsKernelsAVX512 = RS_KERNELS_TABLE("AVX-512");
+
+#endif
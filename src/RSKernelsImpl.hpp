@@ -0,0 +1,167 @@
+// Kernel bodies, included once per instruction set by RSKernels*.cpp with RS_KERNELS_ISA naming
+// the namespace, the compiler vectorises the loops for whatever ISA the TU targets
+// State flags are kept as 1.0f / 0.0f and the offset counts as floats inside the loops so every
+// condition is a float compare and select, mixing bool masks stops GCC vectorising
+
+#include "RSKernels.hpp"
+
+namespace RS_KERNELS_ISA {
+namespace {
+
+// Same state machine as the original per channel RSSlew code
+template <int CHANNELS>
+int slew(float* __restrict prior, float* __restrict target, int32_t* __restrict offset, const float* __restrict in, float* __restrict out, float* __restrict gate, int channels, int shiftTime) {
+	const int channelCount = CHANNELS ? CHANNELS : channels;
+	const float shift = (float)shiftTime;
+	float active = 0.0f;
+
+	for(int channel = 0; channel < channelCount; channel++) {
+		float currentValue = in[channel];
+		float priorValue = prior[channel];
+		float targetValue = target[channel];
+		float offsetCount = (float)offset[channel];
+
+		priorValue = offsetCount < 0.0f ? currentValue : priorValue;
+		offsetCount = offsetCount < 0.0f ? 0.0f : offsetCount;
+
+		priorValue = offsetCount >= shift ? currentValue : priorValue;
+		targetValue = offsetCount >= shift ? currentValue : targetValue;
+		offsetCount = offsetCount >= shift ? 0.0f : offsetCount;
+
+		float slewing = offsetCount != 0.0f ? 1.0f : 0.0f;
+		float start = currentValue != priorValue ? 1.0f - slewing : 0.0f;
+		targetValue = start != 0.0f ? currentValue : targetValue;
+		offsetCount = start != 0.0f ? 1.0f : offsetCount;
+		slewing += start;
+
+		float retarget = currentValue != targetValue ? slewing : 0.0f;
+		float lastKnown = ((shift - (offsetCount - 1.0f)) * priorValue + (offsetCount - 1.0f) * targetValue) / shift;
+		targetValue = retarget != 0.0f ? currentValue : targetValue;
+		priorValue = retarget != 0.0f ? lastKnown : priorValue;
+		offsetCount = retarget != 0.0f ? 0.0f : offsetCount;
+
+		float slewed = ((shift - offsetCount) * priorValue + offsetCount * currentValue) / shift;
+		out[channel] = slewing != 0.0f ? slewed : currentValue;
+		gate[channel] = slewing * 10.0f;
+		offsetCount += slewing;
+		active += slewing;
+
+		prior[channel] = priorValue;
+		target[channel] = targetValue;
+		offset[channel] = (int32_t)offsetCount;
+	}
+
+	return (int)active;
+}
+
+void randBlend(const float* __restrict base, const float* __restrict noise, float amount, float* __restrict out, int count) {
+	for(int i = 0; i < count; i++) {
+		float value = base[i] + noise[i] * amount;
+		value = value < 0.0f ? 0.0f : value;
+		out[i] = value > 1.0f ? 1.0f : value;
+	}
+}
+
+// As slew() but a new target restarts at offset 0 and a zero shiftTime never slews
+int randSlew(const float* __restrict current, float* __restrict prior, float* __restrict target, int32_t* __restrict offset, float* __restrict out, uint64_t* __restrict mask, int count, int shiftTime) {
+	const float shift = (float)shiftTime;
+	const float divisor = shiftTime > 0 ? shift : 1.0f;
+	float active = 0.0f;
+
+	// 64 params at a time into byte flags so the slew stays vectorised, then packed to one mask word
+	for(int first = 0; first < count; first += 64) {
+		const int n = count - first < 64 ? count - first : 64;
+		uint8_t flags[64] = {};
+
+		for(int j = 0; j < n; j++) {
+			int i = first + j;
+			float currentValue = current[i];
+			float priorValue = prior[i];
+			float targetValue = target[i];
+			float offsetCount = (float)offset[i];
+
+			priorValue = offsetCount < 0.0f ? currentValue : priorValue;
+			offsetCount = offsetCount < 0.0f ? 0.0f : offsetCount;
+
+			priorValue = offsetCount >= shift ? currentValue : priorValue;
+			targetValue = offsetCount >= shift ? currentValue : targetValue;
+			offsetCount = offsetCount >= shift ? 0.0f : offsetCount;
+
+			float isSlewing = offsetCount != 0.0f ? 1.0f : 0.0f;
+			float start = currentValue != priorValue ? 1.0f - isSlewing : 0.0f;
+			targetValue = start != 0.0f ? currentValue : targetValue;
+			isSlewing += start;
+
+			float retarget = currentValue != targetValue ? isSlewing : 0.0f;
+			float lastKnown = ((shift - (offsetCount - 1.0f)) * priorValue + (offsetCount - 1.0f) * targetValue) / divisor;
+			targetValue = retarget != 0.0f ? currentValue : targetValue;
+			priorValue = retarget != 0.0f ? lastKnown : priorValue;
+			offsetCount = retarget != 0.0f ? 0.0f : offsetCount;
+
+			out[i] = ((shift - offsetCount) * priorValue + offsetCount * currentValue) / divisor;
+			flags[j] = (uint8_t)isSlewing;
+			offsetCount += isSlewing;
+			active += isSlewing;
+
+			prior[i] = priorValue;
+			target[i] = targetValue;
+			offset[i] = (int32_t)offsetCount;
+		}
+
+		// Multiply gathers the low bit of each of 8 bytes into the top byte, little endian
+		uint64_t bits = 0;
+		for(int b = 0; b < 8; b++) {
+			uint64_t bytes;
+			__builtin_memcpy(&bytes, flags + b * 8, 8);
+			bits |= ((bytes * 0x0102040810204080ull) >> 56) << (b * 8);
+		}
+		mask[first / 64] = bits;
+	}
+
+	return (int)active;
+}
+
+void noise(RSNoise& noise, float* __restrict out, int count) {
+	uint32_t state[RS_NOISE_LANES];
+	for(int lane = 0; lane < RS_NOISE_LANES; lane++) state[lane] = noise.state[lane];
+
+	for(int block = 0; block < count; block += RS_NOISE_LANES) {
+		for(int lane = 0; lane < RS_NOISE_LANES; lane++) {
+			uint32_t x = state[lane];
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			state[lane] = x;
+			out[block + lane] = (float)(int32_t)(x >> 8) * (1.0f / 16777216.0f) - 0.5f;
+		}
+	}
+
+	for(int lane = 0; lane < RS_NOISE_LANES; lane++) noise.state[lane] = state[lane];
+}
+
+void walk(float* __restrict current, const float* __restrict base, const float* __restrict noise, float step, float range, int count) {
+	for(int i = 0; i < count; i++) {
+		float lo = base[i] - range * 0.5f;
+		float hi = base[i] + range * 0.5f;
+		lo = lo < 0.0f ? 0.0f : lo;
+		hi = hi > 1.0f ? 1.0f : hi;
+
+		float value = current[i] + noise[i] * step;
+		value = value < lo ? 2.0f * lo - value : value;
+		value = value > hi ? 2.0f * hi - value : value;
+		value = value < lo ? lo : value;
+		current[i] = value > hi ? hi : value;
+	}
+}
+
+}
+}
+
+#define RS_KERNELS_TABLE(label) { \
+	label, \
+	{RS_KERNELS_ISA::slew<0>, RS_KERNELS_ISA::slew<1>, RS_KERNELS_ISA::slew<4>, RS_KERNELS_ISA::slew<8>, RS_KERNELS_ISA::slew<16>}, \
+	RS_KERNELS_ISA::randBlend, \
+	RS_KERNELS_ISA::randSlew, \
+	RS_KERNELS_ISA::noise, \
+	RS_KERNELS_ISA::walk \
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cassert>
+
+#include "RS.hpp"
+#include "RSProfile.hpp"
+#include "RSTelemetry.hpp"
+
+// Reusable base for RS modules
+// A module describes its panel with a constexpr RSModuleDesc, RSModule<T> configures the params,
+// ports and JSON from it and RSModuleWidget<T> lays the panel out with RS_ROW_COMP / RS_ROW_LABEL
+//
+// The derived module provides:
+//	static const RSModuleDesc& desc();
+//	template <int CHANNELS> void processChannels(const ProcessArgs& args, int channels);
+// and optionally hides channelCount(), toJson(), fromJson() and appendContextMenu()
+//
+// processChannels<CHANNELS> is instantiated for 1, 4, 8 and 16 channels so loops over CHANNELS
+// unroll fully, any other channel count goes to processChannels<0> with the runtime count
+
+#define RS_COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+#define RS_MAX_OPTIONS 8
+
+enum RSRowType {
+	RS_ROW_KNOB,
+	RS_ROW_BUTTON,
+	RS_ROW_TOGGLE,
+	RS_ROW_INPUT,
+	RS_ROW_OUTPUT
+};
+
+struct RSRow {
+	RSRowType type;
+	int id;				// Param, input or output id
+	const char* label;	// Panel label
+	const char* name;	// Tooltip
+	float minValue, maxValue, defaultValue;
+	const char* unit;
+	bool poly;
+};
+
+constexpr RSRow rsKnobRow(int id, const char* label, const char* name, float minValue, float maxValue, float defaultValue, const char* unit = "") {
+	return RSRow{RS_ROW_KNOB, id, label, name, minValue, maxValue, defaultValue, unit, false};
+}
+constexpr RSRow rsButtonRow(int id, const char* label, const char* name) {
+	return RSRow{RS_ROW_BUTTON, id, label, name, 0.0f, 1.0f, 0.0f, "", false};
+}
+constexpr RSRow rsToggleRow(int id, const char* label, const char* name, float defaultValue = 0.0f) {
+	return RSRow{RS_ROW_TOGGLE, id, label, name, 0.0f, 1.0f, defaultValue, "", false};
+}
+constexpr RSRow rsInputRow(int id, const char* label, const char* name, bool poly = false) {
+	return RSRow{RS_ROW_INPUT, id, label, name, 0.0f, 0.0f, 0.0f, "", poly};
+}
+constexpr RSRow rsOutputRow(int id, const char* label, const char* name, bool poly = false) {
+	return RSRow{RS_ROW_OUTPUT, id, label, name, 0.0f, 0.0f, 0.0f, "", poly};
+}
+
+// Context menu toggles, persisted under key
+struct RSOption {
+	const char* key;
+	const char* label;
+	bool defaultValue;
+};
+
+struct RSModuleDesc {
+	const char* title;
+	int hp;
+	const RSRow* rows;
+	int numRows;
+	const RSOption* options;
+	int numOptions;
+	int bypassInput;	// -1 for none
+	int bypassOutput;
+};
+
+template <typename TModule>
+struct RSModule : Module {
+	bool options[RS_MAX_OPTIONS] = {};
+	int activity = 0;	// Channels active this sample, reported to telemetry
+
+	RSTelemetry telemetry;
+
+#ifdef RS_PROFILE
+	RSProfiler profiler;
+#endif
+
+	RSModule() {
+		const RSModuleDesc& desc = TModule::desc();
+		assert(desc.numOptions <= RS_MAX_OPTIONS && "RSModuleDesc has more options than RS_MAX_OPTIONS");
+
+		config(TModule::NUM_PARAMS, TModule::NUM_INPUTS, TModule::NUM_OUTPUTS, TModule::NUM_LIGHTS);
+
+		for(int r = 0; r < desc.numRows; r++) {
+			const RSRow& row = desc.rows[r];
+			switch(row.type) {
+				case RS_ROW_KNOB:	configParam(row.id, row.minValue, row.maxValue, row.defaultValue, row.name, row.unit); break;
+				case RS_ROW_BUTTON:	configButton(row.id, row.name); break;
+				case RS_ROW_TOGGLE:	configSwitch(row.id, 0.0f, 1.0f, row.defaultValue, row.name, {"OFF", "ON"}); break;
+				case RS_ROW_INPUT:	configInput(row.id, row.name); break;
+				case RS_ROW_OUTPUT:	configOutput(row.id, row.name); break;
+			}
+		}
+
+		if(desc.bypassInput >= 0 && desc.bypassOutput >= 0) configBypass(desc.bypassInput, desc.bypassOutput);
+
+		for(int o = 0; o < numOptions(); o++) options[o] = desc.options[o].defaultValue;
+	}
+
+	// Options in use, never more than options[] holds even if the assert is compiled out
+	static int numOptions() {
+		return std::min(TModule::desc().numOptions, RS_MAX_OPTIONS);
+	}
+
+	// Defaults, hidden by the derived module where needed
+	int channelCount() { return 1; }
+	void toJson(json_t* rootJ) {}
+	void fromJson(json_t* rootJ) {}
+	void appendContextMenu(Menu* menu) {}
+
+	void process(const ProcessArgs& args) override {
+		RS_PROFILE_SCOPE(profiler, RS_PROFILE_PROCESS);
+		RS_PROFILE_PUBLISH(profiler, args.sampleTime);
+		RSTelemetryScope processTelemetry(telemetry, RS_TELEMETRY_PROCESS, args.frame);
+
+		TModule* m = static_cast<TModule*>(this);
+		int channels = m->channelCount();
+
+		activity = 0;
+		switch(channels) {
+			case 1:  m->template processChannels<1>(args, 1); break;
+			case 4:  m->template processChannels<4>(args, 4); break;
+			case 8:  m->template processChannels<8>(args, 8); break;
+			case 16: m->template processChannels<16>(args, 16); break;
+			default: m->template processChannels<0>(args, channels); break;
+		}
+		processTelemetry.count = activity;
+	}
+
+	json_t* dataToJson() override {
+		const RSModuleDesc& desc = TModule::desc();
+		json_t* rootJ = json_object();
+
+		for(int o = 0; o < numOptions(); o++)
+			json_object_set_new(rootJ, desc.options[o].key, json_boolean(options[o]));
+
+		static_cast<TModule*>(this)->toJson(rootJ);
+
+		return rootJ;
+	}
+
+	void dataFromJson(json_t* rootJ) override {
+		const RSModuleDesc& desc = TModule::desc();
+
+		for(int o = 0; o < numOptions(); o++) {
+			json_t* optionJ = json_object_get(rootJ, desc.options[o].key);
+			if(optionJ) options[o] = json_boolean_value(optionJ);
+		}
+
+		static_cast<TModule*>(this)->fromJson(rootJ);
+	}
+};
+
+template <typename TModule>
+struct RSModuleWidget : ModuleWidget {
+	TModule* module;
+
+	RSModuleWidget(TModule* module) {
+		setModule(module);
+		this->module = module;
+
+		const RSModuleDesc& desc = TModule::desc();
+
+		box.size.x = mm2px(5.08 * desc.hp);
+		int middle = box.size.x / 2 + 1;
+
+		addChild(new RSLabelCentered(middle, box.pos.y + 15, desc.title, RS_TITLE_FONT_SIZE, module));
+
+		addChild(new RSLabelCentered(middle, box.size.y - 17, "Racket", RS_TITLE_FONT_SIZE, module));
+		addChild(new RSLabelCentered(middle, box.size.y - 5, "Science", RS_TITLE_FONT_SIZE, module));
+
+		for(int r = 0; r < desc.numRows; r++) {
+			const RSRow& row = desc.rows[r];
+			Vec pos = Vec(middle, RS_ROW_COMP(r));
+
+			switch(row.type) {
+				case RS_ROW_KNOB:	addParam(createParamCentered<RSKnobSml>(pos, module, row.id)); break;
+				case RS_ROW_BUTTON:	addParam(createParamCentered<RSButtonMomentary>(pos, module, row.id)); break;
+				case RS_ROW_TOGGLE:	addParam(createParamCentered<RSButtonToggle>(pos, module, row.id)); break;
+				case RS_ROW_INPUT:
+					if(row.poly) addInput(createInputCentered<RSJackPolyIn>(pos, module, row.id));
+					else 		 addInput(createInputCentered<RSJackMonoIn>(pos, module, row.id));
+					break;
+				case RS_ROW_OUTPUT:
+					if(row.poly) addOutput(createOutputCentered<RSJackPolyOut>(pos, module, row.id));
+					else 		 addOutput(createOutputCentered<RSJackMonoOut>(pos, module, row.id));
+					break;
+			}
+			addChild(new RSLabelCentered(middle, RS_ROW_LABEL(r), row.label, RS_LABEL_FONT_SIZE, module));
+		}
+	};
+
+	#include "RSModuleWidgetDraw.hpp"
+
+	virtual void customDraw(const DrawArgs& args) {}
+
+	void appendContextMenu(Menu* menu) override {
+		if(!module) return;
+
+		const RSModuleDesc& desc = TModule::desc();
+		TModule* module = this->module;
+
+		menu->addChild(new MenuSeparator);
+
+		for(int o = 0; o < TModule::numOptions(); o++)
+			menu->addChild(createBoolPtrMenuItem(desc.options[o].label, "", &module->options[o]));
+
+		menu->addChild(createBoolMenuItem("Log telemetry", "",
+			[=]() { return module->telemetry.isEnabled(); },
+			[=](bool on) { module->telemetry.setEnabled(on, string::f("%s-%lld", module->model->slug.c_str(), (long long)module->id)); }));
+
+		module->appendContextMenu(menu);
+
+		RS_PROFILE_MENU(menu, module->profiler);
+	}
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+// Hot path profiling counters, build with FLAGS += -DRS_PROFILE to enable
+// With RS_PROFILE undefined every RS_PROFILE_* macro expands to nothing
+
+#ifdef RS_PROFILE
+
+#include <atomic>
+#include <chrono>
+
+enum RSProfileSection {
+	RS_PROFILE_PROCESS,
+	RS_PROFILE_TICK,
+	RS_PROFILE_TRIGGER,
+	RS_PROFILE_SLEW,
+	RS_PROFILE_SECTIONS
+};
+
+struct RSProfiler {
+	// Accumulated on the audio thread
+	int64_t totalNs[RS_PROFILE_SECTIONS] = {};
+	int64_t maxNs[RS_PROFILE_SECTIONS] = {};
+	int64_t calls[RS_PROFILE_SECTIONS] = {};
+	int64_t paramWrites = 0;
+	int64_t slewsActive = 0;
+	float elapsed = 0.0f;
+
+	// Published once a second for the UI thread to read
+	std::atomic<float> avgNsOut[RS_PROFILE_SECTIONS];
+	std::atomic<float> maxNsOut[RS_PROFILE_SECTIONS];
+	std::atomic<float> writesPerSecondOut;
+	std::atomic<float> activeSlewsOut;
+
+	RSProfiler() {
+		for(int s = 0; s < RS_PROFILE_SECTIONS; s++) {
+			avgNsOut[s] = 0.0f;
+			maxNsOut[s] = 0.0f;
+		}
+		writesPerSecondOut = 0.0f;
+		activeSlewsOut = 0.0f;
+	}
+
+	void record(int section, int64_t ns) {
+		totalNs[section] += ns;
+		calls[section]++;
+		if(ns > maxNs[section]) maxNs[section] = ns;
+	}
+
+	void publish(float sampleTime) {
+		elapsed += sampleTime;
+		if(elapsed < 1.0f) return;
+
+		activeSlewsOut = calls[RS_PROFILE_SLEW] ? (float)slewsActive / calls[RS_PROFILE_SLEW] : 0.0f;
+		writesPerSecondOut = paramWrites / elapsed;
+
+		for(int s = 0; s < RS_PROFILE_SECTIONS; s++) {
+			avgNsOut[s] = calls[s] ? (float)totalNs[s] / calls[s] : 0.0f;
+			maxNsOut[s] = (float)maxNs[s];
+			totalNs[s] = maxNs[s] = calls[s] = 0;
+		}
+
+		paramWrites = slewsActive = 0;
+		elapsed = 0.0f;
+	}
+
+	void appendMenu(Menu* menu) {
+		static const char* names[RS_PROFILE_SECTIONS] = {"process", "tick", "trigger", "slew"};
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Profile (avg / max ns)"));
+		for(int s = 0; s < RS_PROFILE_SECTIONS; s++) {
+			if(maxNsOut[s] == 0.0f) continue;
+			menu->addChild(createMenuLabel(string::f("%s: %.0f / %.0f", names[s], avgNsOut[s].load(), maxNsOut[s].load())));
+		}
+		menu->addChild(createMenuLabel(string::f("Params written: %.0f /s", writesPerSecondOut.load())));
+		menu->addChild(createMenuLabel(string::f("Active slews: %.1f", activeSlewsOut.load())));
+	}
+};
+
+struct RSProfileScope {
+	RSProfiler& profiler;
+	int section;
+	std::chrono::steady_clock::time_point start;
+
+	RSProfileScope(RSProfiler& profiler, int section) : profiler(profiler), section(section) {
+		start = std::chrono::steady_clock::now();
+	}
+
+	~RSProfileScope() {
+		profiler.record(section, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+};
+
+#define RS_PROFILE_SCOPE(profiler, section)	RSProfileScope rsProfileScope##section(profiler, section)
+#define RS_PROFILE_PARAM_WRITE(profiler)	(profiler).paramWrites++
+#define RS_PROFILE_SLEWS_ACTIVE(profiler, n)	(profiler).slewsActive += (n)
+#define RS_PROFILE_PUBLISH(profiler, dt)	(profiler).publish(dt)
+#define RS_PROFILE_MENU(menu, profiler)		(profiler).appendMenu(menu)
+
+#else
+
+#define RS_PROFILE_SCOPE(profiler, section)
+#define RS_PROFILE_PARAM_WRITE(profiler)	((void)0)
+#define RS_PROFILE_SLEWS_ACTIVE(profiler, n)	((void)0)
+#define RS_PROFILE_PUBLISH(profiler, dt)	((void)0)
+#define RS_PROFILE_MENU(menu, profiler)		((void)0)
+
+#endif
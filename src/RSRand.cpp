@@ -1,6 +1,12 @@
 #include "plugin.hpp"
 
+#include <mutex>
+
 #include "RS.hpp"
+#include "RSProfile.hpp"
+#include "RSTelemetry.hpp"
+#include "RSKernels.hpp"
+#include "RSUndo.hpp"
 
 struct RSRand : Module
 {
@@ -22,6 +28,8 @@ struct RSRand : Module
 	};
 	enum OutputIds
 	{
+		GATE_OUTPUT,
+		ACTIVE_OUTPUT,
 		NUM_OUTPUTS
 	};
 	enum LightIds
@@ -33,12 +41,16 @@ struct RSRand : Module
 	dsp::ClockDivider modDivider;
 	int modDiv = 32;
 
+	dsp::ClockDivider lightDivider;
+	bool slewSeen = false;	// Anything slewed since the light was last updated
+
 	dsp::SchmittTrigger randTrigger;
 	dsp::SchmittTrigger pivotTrigger;
 
 	// Right module ID tracking
 	int64_t RMId = -1;
 	int64_t priorRMId = -2;
+	int64_t restoredRMId = -1;	// Right module the JSON state was saved against
 
 	// For PIVOTing
 	std::vector<float> storedValue;
@@ -47,13 +59,43 @@ struct RSRand : Module
 	std::vector<float> currentValue;
 	std::vector<float> priorValue;
 	std::vector<float> targetValue;
-	std::vector<int> offsetCount;
+	std::vector<int32_t> offsetCount;
+
+	// Scratch for the kernels, sized with the above
+	std::vector<float> liveValue;
+	std::vector<float> noise;
+	std::vector<float> outputValue;
+	std::vector<uint64_t> slewMask;	// Bit per param, set while it's slewing or walking
+
+	// For WALKing, params wander continuously around the PIVOT snapshot or where they were when the walk began
+	bool walk = false;
+	std::atomic<bool> walkRebase{true};
+	std::vector<float> walkBase;
+	RSNoise noiseGen;
+
+	// For undoing randomisations, one history entry per randomisation
+	// Only RAND button presses by default, a clocked RSRand would flood the history and push the user's own edits out
+	RSUndoArena undoArena;
+	bool undoTriggers = false;
+	std::atomic<bool> resync{false};	// Set by undo / redo, reload the slew state from the right module
+
+	// The slew state vectors are resized by a rescan on the audio thread and read / replaced by the JSON
+	// on the UI thread, the audio thread holds this for each tick but only try_locks, skipping a tick
+	// rather than waiting on a save
+	// Undo / redo hold it too while restoring params so a tick can't slew over them before the resync
+	std::mutex stateMutex;
 
 	// Options
 	bool freeze;
 	bool force;
 	bool exclude;
 
+#ifdef RS_PROFILE
+	RSProfiler profiler;
+#endif
+
+	RSTelemetry telemetry;
+
 	RSRand()
 	{
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -63,10 +105,14 @@ struct RSRand : Module
 		configParam(SLEW_KNOB, 0.0f, 5.0f, 0.0f, "Slew", " S");
 		configSwitch(PIVOT_BUTTON, 0.0f, 1.0f, 0.0f, "Pivot", {"OFF", "ON"});
 		configInput(RAND_INPUT, "Randomisation trigger");
+		configOutput(GATE_OUTPUT, "High when slewing");
+		configOutput(ACTIVE_OUTPUT, "Slewing per param group");
 
 		// freeze force exclude
 
 		modDivider.setDivision(modDiv);
+		lightDivider.setDivision(16);
+		noiseGen.seed(random::u32());
 	}
 
 	void process(const ProcessArgs &args) override
@@ -75,14 +121,27 @@ struct RSRand : Module
 		if (!m)
 			return;
 
+		RS_PROFILE_SCOPE(profiler, RS_PROFILE_PROCESS);
+		RS_PROFILE_PUBLISH(profiler, args.sampleTime);
 
 		if (modDivider.process())
 		{
+			std::unique_lock<std::mutex> stateLock(stateMutex, std::try_to_lock);
+			if (!stateLock.owns_lock())
+				return;
+
+			RS_PROFILE_SCOPE(profiler, RS_PROFILE_TICK);
+			RSTelemetryScope tickTelemetry(telemetry, RS_TELEMETRY_TICK, args.frame);
+
 			RMId = m->rightExpander.moduleId;
 
 			ModuleWidget *mw = APP->scene->rack->getModule(RMId);
 			if (!mw)
+			{ // Nothing to slew, let the GATE and light fall, the mask keeps its size in case the same module comes back
+				std::fill(slewMask.begin(), slewMask.end(), 0);
+				processActivity(args);
 				return;
+			}
 
 			if (RMId != priorRMId)
 			{ // We're initialising or have a new right module
@@ -99,43 +158,88 @@ struct RSRand : Module
 				int params = (int)(mw->getParams().size());
 				printf("RSRand:%i params\n", params);
 
-				// Initialise vectors
-				currentValue.clear();
-				currentValue.reserve(params);
-				priorValue.clear();
-				priorValue.reserve(params);
-				targetValue.clear();
-				targetValue.reserve(params);
-				offsetCount.clear();
-				offsetCount.reserve(params);
+				bool restored = RMId == restoredRMId && (int)currentValue.size() == params &&
+								(int)priorValue.size() == params && (int)targetValue.size() == params && (int)offsetCount.size() == params;
+				restoredRMId = -1;
 
+				if (!restored)
+				{ // Initialise vectors, a restore against the same right module resumes any in-flight slews
+					currentValue.assign(params, 0.0f);
+					priorValue.assign(params, 0.0f);
+					targetValue.assign(params, 0.0f);
+					offsetCount.assign(params, -1);
+
+					int i = 0;
+					for (ParamWidget *param : mw->getParams())
+						currentValue[i++] = param->getParamQuantity()->getScaledValue();
+				}
+
+				liveValue.assign(params, 0.0f);
+				noise.assign(rsNoiseSize(params), 0.0f);
+				outputValue.assign(params, 0.0f);
+				slewMask.assign(rsMaskWords(params), 0);
+				walkRebase = true;
+			}
+
+			if (resync.exchange(false))
+			{ // Undo / redo moved the params, drop any in-flight slews and start from where they are now
+				int count = (int)currentValue.size();
 				int i = 0;
 				for (ParamWidget *param : mw->getParams())
 				{
-					offsetCount.push_back(-1);
-					currentValue[i++] = param->getParamQuantity()->getScaledValue();
+					if (i >= count)
+						break;
+					currentValue[i] = param->getParamQuantity()->getScaledValue();
+					offsetCount[i] = -1;
+					i++;
 				}
 			}
 
 			// This probably needs to go outside of the divider, inside we can miss triggers depending on length & divider setting
 			if (randTrigger.process(params[RAND_BUTTON].getValue() + inputs[RAND_INPUT].getVoltage()))
 			{
+				RS_PROFILE_SCOPE(profiler, RS_PROFILE_TRIGGER);
+				RSTelemetryScope triggerTelemetry(telemetry, RS_TELEMETRY_TRIGGER, args.frame);
+
+				int count = (int)currentValue.size();
 				int i = 0;
 				for (ParamWidget *param : mw->getParams())
 				{
-					if (params[PIVOT_BUTTON].getValue() && !storedValue.empty()) // If PIVOTing
-						currentValue[i] = storedValue[i];						 // use previously stored parameters
-					else														 // else use live parameters and get a bonus random walk for free
-						currentValue[i] = param->getParamQuantity()->getScaledValue();
-
-					float r = (float)rand() / (float)RAND_MAX - 0.5f;
-					currentValue[i] = std::max(0.0f, std::min(currentValue[i] + (r * params[RAND_KNOB].getValue()), 1.0f));
+					if (i >= count)
+						break;
+					liveValue[i] = param->getParamQuantity()->getScaledValue();
+					i++;
+				}
+				rsKernels->noise(noiseGen, noise.data(), count);
 
-					if (!params[SLEW_KNOB].getValue() && param->getParamQuantity()->randomizeEnabled)
-						param->getParamQuantity()->setScaledValue(currentValue[i]);
+				// If PIVOTing use previously stored parameters, else use live parameters and get a bonus random walk for free
+				bool pivoting = params[PIVOT_BUTTON].getValue() && (int)storedValue.size() == count;
+				rsKernels->randBlend(pivoting ? storedValue.data() : liveValue.data(), noise.data(), params[RAND_KNOB].getValue(), currentValue.data(), count);
 
+				// Record what changes for undo, writing directly if we're not slewing
+				bool record = params[RAND_BUTTON].getValue() || undoTriggers;
+				bool direct = !params[SLEW_KNOB].getValue();
+				i = 0;
+				for (ParamWidget *param : mw->getParams())
+				{
+					if (i >= count)
+						break;
+					ParamQuantity *paramQuantity = param->getParamQuantity();
+					if ((paramQuantity->randomizeEnabled || (force && !direct)) && currentValue[i] != liveValue[i])
+					{
+						if (record)
+							undoArena.add(paramQuantity->paramId, liveValue[i], currentValue[i]);
+						if (direct)
+						{
+							paramQuantity->setScaledValue(currentValue[i]);
+							RS_PROFILE_PARAM_WRITE(profiler);
+						}
+					}
 					i++;
 				}
+				if (record)
+					undoArena.commit(RMId);
+				triggerTelemetry.count = count;
 			}
 
 			if (pivotTrigger.process(params[PIVOT_BUTTON].getValue()))
@@ -153,102 +257,260 @@ struct RSRand : Module
 			float slewTime = params[SLEW_KNOB].getValue();
 			int shiftTime = slewTime * args.sampleRate / modDiv;
 
-			int i = 0;
-
-			if (!freeze)
+			if (!freeze && walk)
 			{
-				for (ParamWidget *param : mw->getParams())
-				{
-
-					// As we are NOT setting this on a trigger like before, Stoermelder GRIPs are being overridden
-					// Setting GRIP to audio rate processing appears to alleviate this
-
-					if (offsetCount[i] < 0)
+				RS_PROFILE_SCOPE(profiler, RS_PROFILE_SLEW);
+				RSTelemetryScope walkTelemetry(telemetry, RS_TELEMETRY_SLEW, args.frame);
+
+				int count = (int)currentValue.size();
+				bool pivoting = params[PIVOT_BUTTON].getValue() && (int)storedValue.size() == count;
+				if (walkRebase.exchange(false) || (int)walkBase.size() != count)
+				{ // Start from where the params are now, currentValue is only as fresh as the last trigger
+					int i = 0;
+					for (ParamWidget *param : mw->getParams())
 					{
-						priorValue[i] = currentValue[i];
-						offsetCount[i] = 0;
+						if (i >= count)
+							break;
+						currentValue[i] = param->getParamQuantity()->getScaledValue();
+						i++;
 					}
+					walkBase.assign(currentValue.begin(), currentValue.end());
+				}
 
-					bool slewing = offsetCount[i] != 0;
-					float outputValue = currentValue[i];
+				// % sets how far params may wander, SLEW roughly how long they take to cover half of that
+				float range = params[RAND_KNOB].getValue();
+				float walkTime = std::max(params[SLEW_KNOB].getValue(), 0.1f);
+				float step = range * 1.732f * std::sqrt(modDiv * args.sampleTime / walkTime);
 
-					if (offsetCount[i] >= shiftTime)
-					{
-						offsetCount[i] = 0;
-						priorValue[i] = currentValue[i];
-						targetValue[i] = currentValue[i];
-						slewing = false;
-					}
+				rsKernels->noise(noiseGen, noise.data(), count);
+				rsKernels->walk(currentValue.data(), pivoting ? storedValue.data() : walkBase.data(), noise.data(), step, range, count);
 
-					if (!slewing)
-					{
-						if (currentValue[i] != priorValue[i])
-						{
-							targetValue[i] = currentValue[i];
-							offsetCount[i] = 0;
-							slewing = true;
-						}
-					}
+				// Keep the slew state on the walk so leaving WALK doesn't glide anywhere
+				std::copy(currentValue.begin(), currentValue.end(), priorValue.begin());
+				std::copy(currentValue.begin(), currentValue.end(), targetValue.begin());
+				std::fill(offsetCount.begin(), offsetCount.end(), 0);
 
-					if (slewing)
-					{
-						if (currentValue[i] != targetValue[i])
-						{
-							float lastKnown = ((shiftTime - (offsetCount[i] - 1)) * priorValue[i] +
-											   (offsetCount[i] - 1) * targetValue[i]) /
-											  shiftTime;
-							targetValue[i] = currentValue[i];
-							priorValue[i] = lastKnown;
-							offsetCount[i] = 0;
-						}
+				// Every param walks
+				std::fill(slewMask.begin(), slewMask.end(), ~0ull);
+				if (count & 63)
+					slewMask.back() = ~0ull >> (64 - (count & 63));
 
-						outputValue = ((shiftTime - offsetCount[i]) * priorValue[i] +
-									   offsetCount[i] * currentValue[i]) /
-									  shiftTime;
+				writeMasked(mw, currentValue);
+				walkTelemetry.count = count;
+			}
+			else if (!freeze)
+			{
+				RS_PROFILE_SCOPE(profiler, RS_PROFILE_SLEW);
+				RSTelemetryScope slewTelemetry(telemetry, RS_TELEMETRY_SLEW, args.frame);
 
-						offsetCount[i]++;
-					}
+				// As we are NOT setting this on a trigger like before, Stoermelder GRIPs are being overridden
+				// Setting GRIP to audio rate processing appears to alleviate this
+				int count = (int)currentValue.size();
+				int active = rsKernels->randSlew(currentValue.data(), priorValue.data(), targetValue.data(), offsetCount.data(),
+												 outputValue.data(), slewMask.data(), count, shiftTime);
+				RS_PROFILE_SLEWS_ACTIVE(profiler, active);
+				slewTelemetry.count = active;
 
-					if (slewing && (param->getParamQuantity()->randomizeEnabled || force))
-						param->getParamQuantity()->setScaledValue(outputValue); // Only update this when actually slewing?
+				// As is we can't adjust knobs on target module when not slewing as we're constantly updating here.
 
-					// As is we can't adjust knobs on target module when not slewing as we're constantly updating here.
+				writeMasked(mw, outputValue);
+			}
+			else
+				std::fill(slewMask.begin(), slewMask.end(), 0);
 
-					// Would be nice to have a light to indicate when we're slewing,
-					//  this could help to set slew time when triggering rythmically,
-					//	would a slew gate output be of any use?
+			processActivity(args);
+		}
+	}
 
-					i++;
+	// Write the params flagged in slewMask, unless excluded from randomisation and not FORCEd
+	void writeMasked(ModuleWidget *mw, const std::vector<float> &values)
+	{
+		if (!slewMaskSet())
+			return;
+
+		std::vector<ParamWidget *> paramWidgets = mw->getParams();
+		int count = std::min((int)paramWidgets.size(), (int)values.size());
+
+		for (int w = 0; w < (int)slewMask.size(); w++)
+		{
+			for (uint64_t bits = slewMask[w]; bits; bits &= bits - 1)
+			{
+				int i = w * 64 + __builtin_ctzll(bits);
+				if (i >= count)
+					return;
+
+				ParamQuantity *paramQuantity = paramWidgets[i]->getParamQuantity();
+				if (paramQuantity->randomizeEnabled || force)
+				{
+					paramQuantity->setScaledValue(values[i]);
+					RS_PROFILE_PARAM_WRITE(profiler);
 				}
 			}
 		}
 	}
 
+	// Any param slewing
+	bool slewMaskSet()
+	{
+		for (uint64_t bits : slewMask)
+			if (bits)
+				return true;
+		return false;
+	}
+
+	// Any param in [first, last) slewing
+	bool slewMaskAny(int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			uint64_t bits = slewMask[i >> 6] >> (i & 63);
+			if (bits & 1)
+				return true;
+			if (!bits) // Nothing left in this word
+				i |= 63;
+		}
+		return false;
+	}
+
+	// GATE while anything slews, ACTIVE splits the params into up to 16 groups with a channel each
+	// Both come straight from slewMask so cost nothing per param
+	void processActivity(const ProcessArgs &args)
+	{
+		bool any = slewMaskSet();
+
+		outputs[GATE_OUTPUT].setVoltage(any ? 10.0f : 0.0f);
+
+		if (outputs[ACTIVE_OUTPUT].isConnected())
+		{
+			int count = std::min((int)currentValue.size(), (int)slewMask.size() * 64);
+			int groupSize = std::max((count + 15) / 16, 1);
+			int channels = std::max((count + groupSize - 1) / groupSize, 1);
+
+			outputs[ACTIVE_OUTPUT].setChannels(channels);
+			for (int c = 0; c < channels; c++)
+				outputs[ACTIVE_OUTPUT].setVoltage(slewMaskAny(c * groupSize, std::min((c + 1) * groupSize, count)) ? 10.0f : 0.0f, c);
+		}
+
+		// Held so short slews still show
+		slewSeen |= any;
+		if (lightDivider.process())
+		{
+			lights[SLEW_LIGHT].setBrightnessSmooth(slewSeen ? 1.0f : 0.0f, args.sampleTime * modDiv * lightDivider.getDivision());
+			slewSeen = false;
+		}
+	}
+
 	void onReset() override
 	{
 	}
 
+	// FREEZE / FORCE / EXCLUDE are params so Rack saves them, we only add the slew state
 	json_t *dataToJson() override
 	{
+		std::lock_guard<std::mutex> stateLock(stateMutex);
 		json_t *rootJ = json_object();
 
+		json_object_set_new(rootJ, "walk", json_boolean(walk));
+		json_object_set_new(rootJ, "undoTriggers", json_boolean(undoTriggers));
+		json_object_set_new(rootJ, "rightModuleId", json_integer(priorRMId));
+		json_object_set_new(rootJ, "stored", rsPackedToJson(storedValue));
+		json_object_set_new(rootJ, "current", rsPackedToJson(currentValue));
+		json_object_set_new(rootJ, "prior", rsPackedToJson(priorValue));
+		json_object_set_new(rootJ, "target", rsPackedToJson(targetValue));
+		json_object_set_new(rootJ, "offset", rsPackedToJson(offsetCount));
+
 		return rootJ;
 	}
 
 	void dataFromJson(json_t *rootJ) override
 	{
-		// json_t* ?J = json_object_get(rootJ, "?");
+		json_t *walkJ = json_object_get(rootJ, "walk");
+		if (walkJ)
+			walk = json_boolean_value(walkJ);
+
+		json_t *undoTriggersJ = json_object_get(rootJ, "undoTriggers");
+		if (undoTriggersJ)
+			undoTriggers = json_boolean_value(undoTriggersJ);
+
+		json_t *rightModuleIdJ = json_object_get(rootJ, "rightModuleId");
+		if (!rightModuleIdJ)
+			return;
+
+		std::lock_guard<std::mutex> stateLock(stateMutex);
+
+		rsPackedFromJson(json_object_get(rootJ, "stored"), storedValue);
+		rsPackedFromJson(json_object_get(rootJ, "current"), currentValue);
+		rsPackedFromJson(json_object_get(rootJ, "prior"), priorValue);
+		rsPackedFromJson(json_object_get(rootJ, "target"), targetValue);
+		rsPackedFromJson(json_object_get(rootJ, "offset"), offsetCount);
+
+		// Force a rescan, which keeps this state if the right module is the one it was saved against
+		restoredRMId = json_integer_value(rightModuleIdJ);
+		priorRMId = -2;
+	}
+};
+
+// A whole randomisation as a single undo step, owning its deltas so it stays valid however far back it is
+struct RSRandUndoAction : history::ModuleAction
+{
+	int64_t targetId;
+	std::vector<RSUndoDelta> deltas;
+
+	RSRandUndoAction(int64_t moduleId, int64_t targetId, std::vector<RSUndoDelta> &deltas)
+	{
+		name = "randomise";
+		this->moduleId = moduleId;
+		this->targetId = targetId;
+		this->deltas.swap(deltas);
+	}
+
+	void apply(bool undo)
+	{
+		Module *target = APP->engine->getModule(targetId);
+		if (!target)
+			return;
+
+		// Until resync is seen the RSRand would carry on writing its in-flight slews over these params,
+		// holding its state lock keeps ticks out until the flag is set
+		RSRand *randModule = dynamic_cast<RSRand *>(APP->engine->getModule(moduleId));
+		std::unique_lock<std::mutex> stateLock;
+		if (randModule)
+			stateLock = std::unique_lock<std::mutex>(randModule->stateMutex);
+
+		int numParams = (int)target->paramQuantities.size();
+		for (size_t n = 0; n < deltas.size(); n++)
+		{
+			const RSUndoDelta &d = undo ? deltas[deltas.size() - 1 - n] : deltas[n];
+			if (d.paramId < numParams)
+				target->getParamQuantity(d.paramId)->setScaledValue(undo ? d.oldValue : d.newValue);
+		}
+
+		if (randModule)
+			randModule->resync = true;
+	}
+
+	void undo() override
+	{
+		apply(true);
+	}
+
+	void redo() override
+	{
+		apply(false);
 	}
 };
 
 struct RSRandWidget : ModuleWidget
 {
 	RSRand *module;
+	uint64_t undoTaken = 0;	// Undo arena commits already copied out to history
 
 	RSRandWidget(RSRand *module)
 	{
 		setModule(module);
 		this->module = module;
+		if (module)
+			undoTaken = module->undoArena.committed;
 
 		box.size.x = mm2px(5.08 * 3);
 		int middle = box.size.x / 2 + 1;
@@ -258,7 +520,12 @@ struct RSRandWidget : ModuleWidget
 		addChild(new RSLabelCentered(middle, box.size.y - 17, "Racket", RS_TITLE_FONT_SIZE, module));
 		addChild(new RSLabelCentered(middle, box.size.y - 5, "Science", RS_TITLE_FONT_SIZE, module));
 
-		addParam(createParamCentered<RSButtonMomentary>(Vec(middle, RS_ROW_COMP(0)), module, RSRand::RAND_BUTTON));
+		// 3HP keeps the right expander adjacent, so the trigger input sits beside RAND and the outputs share the last row
+		int left = middle - 11;
+		int right = middle + 11;
+
+		addParam(createParamCentered<RSButtonMomentary>(Vec(left, RS_ROW_COMP(0)), module, RSRand::RAND_BUTTON));
+		addInput(createInputCentered<RSJackSmallMonoIn>(Vec(right, RS_ROW_COMP(0)), module, RSRand::RAND_INPUT));
 		addChild(new RSLabelCentered(middle, RS_ROW_LABEL(0), "RAND", RS_LABEL_FONT_SIZE, module));
 
 		addParam(createParamCentered<RSKnobSml>(Vec(middle, RS_ROW_COMP(1)), module, RSRand::RAND_KNOB));
@@ -266,6 +533,7 @@ struct RSRandWidget : ModuleWidget
 
 		addParam(createParamCentered<RSKnobSml>(Vec(middle, RS_ROW_COMP(2)), module, RSRand::SLEW_KNOB));
 		addChild(new RSLabelCentered(middle, RS_ROW_LABEL(2), "SLEW", RS_LABEL_FONT_SIZE, module));
+		addChild(createLightCentered<TinyLight<WhiteLight>>(Vec(box.size.x - 5, RS_ROW_COMP(2) - 10), module, RSRand::SLEW_LIGHT));
 
 		addParam(createParamCentered<RSButtonToggle>(Vec(middle, RS_ROW_COMP(3)), module, RSRand::PIVOT_BUTTON));
 		addChild(new RSLabelCentered(middle, RS_ROW_LABEL(3), "PIVOT", RS_LABEL_FONT_SIZE, module));
@@ -279,8 +547,13 @@ struct RSRandWidget : ModuleWidget
 		addParam(createParamCentered<RSButtonToggle>(Vec(middle, RS_ROW_COMP(6)), module, RSRand::EXCLUDE_BUTTON));
 		addChild(new RSLabelCentered(middle, RS_ROW_LABEL(6), "EXCLUDE", RS_LABEL_FONT_SIZE, module));
 
-		addInput(createInputCentered<RSJackMonoIn>(Vec(middle, RS_ROW_COMP(7)), module, RSRand::RAND_INPUT));
-		addChild(new RSLabelCentered(middle, RS_ROW_LABEL(7), "TRIG", RS_LABEL_FONT_SIZE, module));
+		// The 8mm poly jack needs to sit further in to stay on the panel
+		float gateX = middle - 12;
+		float activeX = box.size.x - 12.5f;
+		addOutput(createOutputCentered<RSJackSmallMonoOut>(Vec(gateX, RS_ROW_COMP(7)), module, RSRand::GATE_OUTPUT));
+		addOutput(createOutputCentered<RSJackPolyOut>(Vec(activeX, RS_ROW_COMP(7)), module, RSRand::ACTIVE_OUTPUT));
+		addChild(new RSLabelCentered(gateX, RS_ROW_LABEL(7), "GATE", RS_LABEL_FONT_SIZE - 2, module));
+		addChild(new RSLabelCentered(activeX, RS_ROW_LABEL(7), "ACT", RS_LABEL_FONT_SIZE - 2, module));
 	};
 
 #include "RSModuleWidgetDraw.hpp"
@@ -288,6 +561,43 @@ struct RSRandWidget : ModuleWidget
 	void customDraw(const DrawArgs &args)
 	{
 	}
+
+	// Randomisations since the last frame become one history entry
+	void step() override
+	{
+		if (module)
+		{
+			uint64_t committed = module->undoArena.committed.load(std::memory_order_acquire);
+			for (; undoTaken < committed; undoTaken++)
+			{ // The arena is only a hand-off, a randomisation it wrapped over before we got here is dropped
+				RSUndoCommit commit;
+				std::vector<RSUndoDelta> deltas;
+				if (module->undoArena.getCommit(undoTaken, commit) && module->undoArena.copy(commit.start, commit.end, deltas))
+					APP->history->push(new RSRandUndoAction(module->id, commit.moduleId, deltas));
+				else
+					WARN("RSRand: randomisation %llu overwritten before reaching the undo history", (unsigned long long)undoTaken);
+			}
+		}
+
+		ModuleWidget::step();
+	}
+
+	void appendContextMenu(Menu *menu) override
+	{
+		if (!module)
+			return;
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createBoolMenuItem("Random walk", "",
+			[=]() { return module->walk; },
+			[=](bool on) { module->walkRebase = true; module->walk = on; }));
+		menu->addChild(createBoolPtrMenuItem("Undo CV triggers", "", &module->undoTriggers));
+		menu->addChild(createBoolMenuItem("Log telemetry", "",
+			[=]() { return module->telemetry.isEnabled(); },
+			[=](bool on) { module->telemetry.setEnabled(on, string::f("RSRand-%lld", (long long)module->id)); }));
+
+		RS_PROFILE_MENU(menu, module->profiler);
+	}
 };
 
 Model *modelRSRand = createModel<RSRand, RSRandWidget>("RSRand");
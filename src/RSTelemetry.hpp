@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+// Per tick timing and event log for offline xrun analysis
+// The audio thread only pushes fixed size records into a lock free SPSC ring,
+// a writer thread drains the ring to a CSV file under <Rack user folder>/RacketScience2
+// The ring only exists while logging so idle modules don't carry it
+
+enum RSTelemetryEvent {
+	RS_TELEMETRY_PROCESS,
+	RS_TELEMETRY_TICK,
+	RS_TELEMETRY_TRIGGER,
+	RS_TELEMETRY_SLEW,
+	RS_TELEMETRY_EVENTS
+};
+
+struct RSTelemetryRecord {
+	int64_t timeNs;		// Steady clock at start of the measured section
+	int64_t frame;		// Engine frame
+	uint32_t durationNs;
+	uint16_t event;
+	uint16_t count;		// Params touched, channels slewing etc.
+};
+
+struct RSTelemetry {
+	static const uint32_t RING_SIZE = 8192;	// Power of 2, ~170ms of per sample records at 48kHz
+	static const uint32_t RING_MASK = RING_SIZE - 1;
+
+	std::atomic<RSTelemetryRecord*> ring{NULL};	// Allocated by start(), freed by stop()
+	std::atomic<bool> pushing{false};			// Audio thread is inside push(), stop() waits it out before freeing
+	std::atomic<uint32_t> head{0};		// Written by the audio thread only
+	std::atomic<uint32_t> tail{0};		// Written by the writer thread only
+	std::atomic<uint32_t> dropped{0};
+	std::atomic<bool> enabled{false};
+	std::atomic<bool> running{false};
+
+	std::thread writer;
+	std::string path;
+
+	~RSTelemetry() {
+		stop();
+	}
+
+	static int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Audio thread, never blocks or allocates, drops the record if the writer has fallen behind
+	// pushing and ring are both seq_cst so either push() sees the ring gone or stop() sees pushing
+	void push(int event, int64_t frame, int64_t timeNs, int64_t durationNs, int count = 0) {
+		pushing.store(true);
+		RSTelemetryRecord* records = ring.load();
+		if(!records) {
+			pushing.store(false, std::memory_order_release);
+			return;
+		}
+
+		uint32_t h = head.load(std::memory_order_relaxed);
+		if(h - tail.load(std::memory_order_acquire) >= RING_SIZE) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		else {
+			RSTelemetryRecord& r = records[h & RING_MASK];
+			r.timeNs = timeNs;
+			r.frame = frame;
+			r.durationNs = (uint32_t)std::min(durationNs, (int64_t)UINT32_MAX);
+			r.event = (uint16_t)event;
+			r.count = (uint16_t)std::min(count, (int)UINT16_MAX);
+
+			head.store(h + 1, std::memory_order_release);
+		}
+		pushing.store(false, std::memory_order_release);
+	}
+
+	bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	// UI thread
+	void start(const std::string& name) {
+		stop();
+
+		std::string dir = asset::user("RacketScience2");
+		system::createDirectories(dir);
+
+		char stamp[32];
+		std::time_t t = std::time(NULL);
+		std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&t));
+		path = dir + "/" + name + "-" + stamp + ".csv";
+
+		RSTelemetryRecord* records = new RSTelemetryRecord[RING_SIZE];
+		tail.store(head.load());
+		dropped = 0;
+		ring.store(records);
+		running = true;
+		writer = std::thread(&RSTelemetry::run, this, records);
+		enabled = true;
+	}
+
+	void stop() {
+		enabled = false;
+		RSTelemetryRecord* records = ring.exchange(NULL);
+		while(pushing.load()) std::this_thread::yield();
+
+		running = false;
+		if(writer.joinable()) writer.join();
+		delete[] records;
+	}
+
+	void setEnabled(bool on, const std::string& name) {
+		if(on) start(name);
+		else stop();
+	}
+
+	// Writer thread
+	void run(const RSTelemetryRecord* records) {
+		static const char* names[RS_TELEMETRY_EVENTS] = {"process", "tick", "trigger", "slew"};
+
+		FILE* file = std::fopen(path.c_str(), "w");
+		if(!file) {
+			WARN("RSTelemetry: cannot open %s", path.c_str());
+			enabled = false;
+			return;
+		}
+		std::fprintf(file, "time_ns,frame,event,duration_ns,count\n");
+
+		bool draining = true;
+		while(draining) {
+			draining = running.load();
+
+			uint32_t t = tail.load(std::memory_order_relaxed);
+			uint32_t h = head.load(std::memory_order_acquire);
+			for(; t != h; t++) {
+				const RSTelemetryRecord& r = records[t & RING_MASK];
+				std::fprintf(file, "%lld,%lld,%s,%u,%u\n", (long long)r.timeNs, (long long)r.frame,
+					r.event < RS_TELEMETRY_EVENTS ? names[r.event] : "?", (unsigned)r.durationNs, (unsigned)r.count);
+			}
+			tail.store(t, std::memory_order_release);
+
+			std::fflush(file);
+			if(draining) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+
+		if(dropped) std::fprintf(file, "# %u records dropped\n", (unsigned)dropped.load());
+		std::fclose(file);
+	}
+};
+
+// Times the enclosing scope when telemetry is enabled, otherwise costs a single relaxed load
+struct RSTelemetryScope {
+	RSTelemetry& telemetry;
+	int event;
+	int64_t frame;
+	int64_t start = 0;
+	int count = 0;
+
+	RSTelemetryScope(RSTelemetry& telemetry, int event, int64_t frame) : telemetry(telemetry), event(event), frame(frame) {
+		if(telemetry.isEnabled()) start = RSTelemetry::now();
+	}
+
+	~RSTelemetryScope() {
+		if(start) telemetry.push(event, frame, start, RSTelemetry::now() - start, count);
+	}
+};
@@ -1,111 +1,84 @@
 #include "plugin.hpp"
 
-#include "RS.hpp"
+#include "RSModule.hpp"
 
-struct RSTemplate : Module {
+struct RSTemplate : RSModule<RSTemplate> {
 	enum ParamIds {
-
+		KNOB,
 		NUM_PARAMS
 	};
 	enum InputIds {
+		INPUT,
 		NUM_INPUTS
 	};
 	enum OutputIds {
+		OUTPUT,
 		NUM_OUTPUTS
 	};
 	enum LightIds {
 		NUM_LIGHTS
 	};
+	enum OptionIds {
+		OPTION,
+		NUM_OPTIONS
+	};
 
+	static const RSModuleDesc& desc() {
+		static constexpr RSRow rows[] = {
+			rsInputRow(INPUT, "IN", "Input", true),
+			rsKnobRow(KNOB, "KNOB", "Knob", 0.0f, 1.0f, 0.5f),
+			rsOutputRow(OUTPUT, "OUT", "Output", true)
+		};
+		static constexpr RSOption moduleOptions[NUM_OPTIONS] = {
+			{"option", "Option", false}
+		};
+		static constexpr RSModuleDesc moduleDesc = {"TITLE", 3, rows, RS_COUNT(rows), moduleOptions, NUM_OPTIONS, INPUT, OUTPUT};
+		return moduleDesc;
+	}
 
 	RSTemplate() {
-		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
-
-	}
 
-	void process(const ProcessArgs& args) override {
-		Module *m = this;
-		if(!m) return;
 	}
 
 	void onReset() override {
 
 
-    }
-
-    json_t* dataToJson() override {
-        json_t* rootJ = json_object();
-
-
-        return rootJ;
-    }
-
-
-	void dataFromJson(json_t* rootJ) override {
-		// json_t* ?J = json_object_get(rootJ, "?");
-
-
 	}
 
-	void contextMenu() {
-
+	int channelCount() {
+		return inputs[INPUT].getChannels();
 	}
-};
-
-
-struct RSTemplateWidget : ModuleWidget {
-    RSTemplate *module;
 
-	RSTemplateWidget(RSTemplate* module) {
-		setModule(module);
-        this->module = module;
+	template <int CHANNELS>
+	void processChannels(const ProcessArgs& args, int channels) {
+		const int channelCount = CHANNELS ? CHANNELS : channels;
 
-		int vs = 45, lo = 25; // Vertical spacing / label offset
-        box.size.x = mm2px(5.08 * 3);
-		int middle = box.size.x / 2 + 1;
+		outputs[OUTPUT].setChannels(channelCount);
 
-		addChild(new RSLabelCentered(middle, box.pos.y + 15, "TITLE", 14, module));
-
-		addChild(new RSLabelCentered(middle, box.size.y - 17, "Racket", 14, module));
-		addChild(new RSLabelCentered(middle, box.size.y - 5, "Science", 14, module));
-
-	};
-
-
-void customDraw(const DrawArgs& args) {}
-//#include "RSModuleWidgetDraw.hpp"
-
-// above include contents:
-// Draws panel background instead of using SVG file
-// Calls customDraw() should we need to draw anything else
-
-void draw(const DrawArgs& args) override {
-    nvgStrokeColor(args.vg, COLOR_RS_BRONZE);
-    nvgFillColor(args.vg, COLOR_RS_GREY);
-
-    nvgStrokeWidth(args.vg, 2);
-    nvgBeginPath(args.vg);
-    nvgRoundedRect(args.vg, 1, 1, box.size.x - 1, box.size.y - 1, 5);
-    nvgStroke(args.vg);
-    nvgFill(args.vg);
-
-    customDraw(args);
+		for(int channel = 0; channel < channelCount; channel++) {
+			outputs[OUTPUT].setVoltage(inputs[INPUT].getVoltage(channel) * params[KNOB].getValue(), channel);
+		}
+	}
 
-    ModuleWidget::draw(args);
-}
+	void toJson(json_t* rootJ) {
 
+	}
 
-void appendContextMenu(Menu* menu) override {
-		RSTemplate* module = dynamic_cast<RSTemplate*>(this->module);
-		assert(module);
+	void fromJson(json_t* rootJ) {
+		// json_t* ?J = json_object_get(rootJ, "?");
 
-		menu->addChild(new MenuSeparator);
+	}
 
+	void appendContextMenu(Menu* menu) {
 		menu->addChild(createMenuItem("Context menu", "",
-			[=]() {module->contextMenu();}
+			[=]() {contextMenu();}
 		));
 	}
+
+	void contextMenu() {
+
+	}
 };
 
 
-Model* modelRSTemplate = createModel<RSTemplate, RSTemplateWidget>("RSTemplate");
+Model* modelRSTemplate = createModel<RSTemplate, RSModuleWidget<RSTemplate>>("RSTemplate");
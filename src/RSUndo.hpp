@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+
+// Fixed size ring of param deltas backing compound undo entries
+// The audio thread add()s the params a randomisation changed then commit()s, recording the range and
+// the module it applies to, the UI thread copies each commit out into its own history action on its
+// next frame
+// The rings only have to cover the randomisations between two UI frames, a commit they wrap over
+// before the UI thread copies it gets no history entry
+
+struct RSUndoDelta {
+	int32_t paramId;
+	float oldValue;
+	float newValue;
+};
+
+struct RSUndoCommit {
+	uint64_t start, end;	// Deltas of one randomisation
+	int64_t moduleId;		// Module they were made to
+};
+
+struct RSUndoArena {
+	static const uint32_t SIZE = 4096;	// Power of 2, 48KB
+	static const uint32_t MASK = SIZE - 1;
+
+	static const uint32_t COMMITS = 64;	// Power of 2, randomisations the UI thread can fall behind by
+	static const uint32_t COMMIT_MASK = COMMITS - 1;
+
+	RSUndoDelta deltas[SIZE];
+	std::atomic<uint64_t> written{0};		// Total deltas ever added
+
+	RSUndoCommit commits[COMMITS];
+	std::atomic<uint64_t> commitsStarted{0};	// Bumped before a commit slot is overwritten
+	std::atomic<uint64_t> committed{0};			// Total commits ever made
+	uint64_t commitStart = 0;					// Audio thread, first delta of the randomisation in progress
+
+	// Audio thread, written is bumped before the slot is overwritten so copy() can spot a wrap
+	void add(int paramId, float oldValue, float newValue) {
+		uint64_t w = written.load(std::memory_order_relaxed);
+		written.store(w + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		RSUndoDelta& d = deltas[w & MASK];
+		d.paramId = paramId;
+		d.oldValue = oldValue;
+		d.newValue = newValue;
+	}
+
+	// Audio thread, a randomisation that changed nothing isn't committed
+	void commit(int64_t moduleId) {
+		uint64_t w = written.load(std::memory_order_relaxed);
+		if(w == commitStart) return;
+
+		uint64_t c = committed.load(std::memory_order_relaxed);
+		commitsStarted.store(c + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		RSUndoCommit& r = commits[c & COMMIT_MASK];
+		r.start = commitStart;
+		r.end = w;
+		r.moduleId = moduleId;
+		commitStart = w;
+
+		committed.store(c + 1, std::memory_order_release);
+	}
+
+	// UI thread, false if commit n has been overwritten
+	bool getCommit(uint64_t n, RSUndoCommit& out) {
+		if(commitsStarted.load(std::memory_order_acquire) - n > COMMITS) return false;
+
+		out = commits[n & COMMIT_MASK];
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return commitsStarted.load(std::memory_order_relaxed) - n <= COMMITS;
+	}
+
+	// UI thread, false if [start, end) has been overwritten
+	bool copy(uint64_t start, uint64_t end, std::vector<RSUndoDelta>& out) {
+		if(end - start > SIZE || written.load(std::memory_order_acquire) - start > SIZE) return false;
+
+		out.clear();
+		out.reserve(end - start);
+		for(uint64_t i = start; i < end; i++) out.push_back(deltas[i & MASK]);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return written.load(std::memory_order_relaxed) - start <= SIZE;
+	}
+};
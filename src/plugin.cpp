@@ -1,10 +1,14 @@
 #include "plugin.hpp"
+#include "RSKernels.hpp"
 
 Plugin *pluginInstance;
 
 void init(Plugin *p) {
 	pluginInstance = p;
 
+	rsKernelsInit();
+	INFO("RacketScience2: using %s DSP kernels", rsKernels->name);
+
 	p->addModel(modelRSRand);
 	p->addModel(modelRSSlew);
 }